@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-2.0
+#
+# Cold-boot benchmark under qemu-system-aarch64 -M raspi3b.
+#
+# Boots out/<profile>/Image RUNS times and reports the median of:
+#   init       kernel timestamp of "Run /init as init process"
+#   userspace  /proc/uptime as first read by /init
+#   wall       host seconds from QEMU launch to /init finishing
+#
+# Usage: RUNS=5 PROFILE=stock [BOOT_ARGS="..."] scripts/boot-bench.sh
+
+set -euo pipefail
+. "$(dirname "$0")/pi-env.sh"
+
+RUNS=${RUNS:-5}
+LOG_DIR=${LOG_DIR:-$OUT_DIR/logs}
+
+need "$QEMU" awk sort
+check_artefacts
+
+mkdir -p "$LOG_DIR"
+results=$(mktemp)
+trap 'rm -f "$results"' EXIT
+
+for i in $(seq 1 "$RUNS"); do
+	log="$LOG_DIR/boot-$i.log"
+	qemu_boot "$log" ${BOOT_ARGS:-} || die "run $i: no boot within ${BOOT_TIMEOUT}s, see $log"
+	boot_times "$log" | tee -a "$results" |
+		awk -v i="$i" '{ printf "run %d: init %.3fs userspace %.3fs wall %.3fs\n", i, $1, $2, $3 }'
+done
+
+printf '%s (%d runs, median): init %.3fs userspace %.3fs wall %.3fs\n' \
+	"$PROFILE" "$RUNS" \
+	"$(awk '{ print $1 }' "$results" | median)" \
+	"$(awk '{ print $2 }' "$results" | median)" \
+	"$(awk '{ print $3 }' "$results" | median)"
@@ -0,0 +1,139 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-2.0
+#
+# Build the Pi kernel and a benchmark initramfs.
+#
+# Produces, in out/<profile>/:
+#   Image               uncompressed arm64 kernel
+#   Image.gz            gzip-compressed kernel
+#   bcm2710-rpi-3-b.dtb device tree for qemu-system-aarch64 -M raspi3b
+#   initramfs.cpio.gz   /init from userspace/init.c
+#   .config             the resolved kernel configuration
+#   kernel-commit       "<sha> <KERNEL_REF>" of the source that was built
+#   modules/            stripped modules, only if CONFIG_MODULES=y
+#
+# Usage: scripts/build.sh [fragment.config ...]
+# Extra config fragments are merged on top of $DEFCONFIG and configs/qemu.config.
+# The build fails if Kconfig does not end up with every value they request.
+
+set -euo pipefail
+. "$(dirname "$0")/pi-env.sh"
+
+need git make "${CROSS_COMPILE}gcc" cpio gzip
+
+# resolve_ref: print the commit $KERNEL_REF names in the local clone, if any.
+# A full SHA is taken as is, anything else must be a tag.
+resolve_ref() {
+	if [[ $KERNEL_REF =~ ^[0-9a-f]{40}$ ]]; then
+		git -C "$KERNEL_SRC" cat-file -e "$KERNEL_REF^{commit}" 2>/dev/null &&
+			echo "$KERNEL_REF"
+	else
+		git -C "$KERNEL_SRC" rev-parse -q --verify "refs/tags/$KERNEL_REF^{commit}"
+	fi
+}
+
+# fetch_kernel: check out exactly $KERNEL_REF, also in an existing tree, and
+# set KERNEL_COMMIT. The remote is only contacted when the ref is not local.
+fetch_kernel() {
+	local src=(git -C "$KERNEL_SRC") head
+
+	if [ ! -d "$KERNEL_SRC/.git" ]; then
+		git init -q "$KERNEL_SRC"
+		"${src[@]}" remote add origin "$KERNEL_URL"
+	fi
+
+	KERNEL_COMMIT=$(resolve_ref) || KERNEL_COMMIT=
+	if [ -z "$KERNEL_COMMIT" ]; then
+		"${src[@]}" remote set-url origin "$KERNEL_URL"
+		[ -z "$("${src[@]}" ls-remote --heads origin "$KERNEL_REF")" ] ||
+			die "KERNEL_REF=$KERNEL_REF is a branch; pin a commit SHA or tag"
+		if [[ $KERNEL_REF =~ ^[0-9a-f]{40}$ ]]; then
+			"${src[@]}" fetch -q --depth 1 origin "$KERNEL_REF"
+		else
+			"${src[@]}" fetch -q --depth 1 origin \
+				"refs/tags/$KERNEL_REF:refs/tags/$KERNEL_REF"
+		fi
+		KERNEL_COMMIT=$(resolve_ref) ||
+			die "KERNEL_REF=$KERNEL_REF does not name a commit"
+	fi
+
+	head=$("${src[@]}" rev-parse -q --verify HEAD) || head=
+	[ "$head" = "$KERNEL_COMMIT" ] ||
+		"${src[@]}" checkout -q --detach "$KERNEL_COMMIT"
+
+	[ -z "$("${src[@]}" status --porcelain --untracked-files=no)" ] ||
+		die "$KERNEL_SRC has local changes; commit them elsewhere or reset the tree"
+	head=$("${src[@]}" rev-parse HEAD)
+	[ "$head" = "$KERNEL_COMMIT" ] ||
+		die "kernel HEAD $head does not match KERNEL_REF=$KERNEL_REF ($KERNEL_COMMIT)"
+	echo "kernel: $head ($KERNEL_REF)"
+}
+
+# check_fragments <fragment...>: fail if Kconfig dropped any requested value,
+# e.g. an option turned off in a fragment but forced back on by a select.
+check_fragments() {
+	local frag line sym got bad=0
+
+	for frag in "$@"; do
+		while read -r line; do
+			case $line in
+			CONFIG_*=*)
+				sym=${line%%=*}
+				grep -qxF "$line" "$BUILD_DIR/.config" && continue
+				;;
+			"# CONFIG_"*" is not set")
+				sym=${line#\# }
+				sym=${sym%% *}
+				grep -q "^$sym=" "$BUILD_DIR/.config" || continue
+				;;
+			*)
+				continue
+				;;
+			esac
+			got=$(grep -E "^($sym=|# $sym is not set)" "$BUILD_DIR/.config" ||
+			      echo "$sym unavailable")
+			echo "${frag#"$TOPDIR"/}: requested '$line', got '$got'" >&2
+			bad=1
+		done < "$frag"
+	done
+	[ "$bad" = 0 ] || die "config fragments not applied as requested"
+}
+
+configure_kernel() {
+	mkdir -p "$BUILD_DIR"
+	kmake "$DEFCONFIG"
+	"$KERNEL_SRC/scripts/kconfig/merge_config.sh" -m -O "$BUILD_DIR" \
+		"$BUILD_DIR/.config" "$TOPDIR/configs/qemu.config" "$@"
+	kmake olddefconfig
+	check_fragments "$TOPDIR/configs/qemu.config" "$@"
+}
+
+build_initramfs() {
+	local root="$BUILD_DIR/initramfs"
+
+	rm -rf "$root"
+	mkdir -p "$root/proc" "$root/dev" "$root/sys"
+	"${CROSS_COMPILE}gcc" -static -O2 -Wall -o "$root/init" \
+		"$TOPDIR/userspace/init.c"
+	(cd "$root" && find . | cpio -o -H newc --quiet) | gzip -9 \
+		> "$OUT_DIR/initramfs.cpio.gz"
+}
+
+fetch_kernel
+configure_kernel "$@"
+kmake Image Image.gz dtbs
+
+mkdir -p "$OUT_DIR"
+cp "$BUILD_DIR/arch/arm64/boot/Image" "$BUILD_DIR/arch/arm64/boot/Image.gz" "$OUT_DIR/"
+cp "$BUILD_DIR/arch/arm64/boot/dts/broadcom/$DTB_NAME" "$OUT_DIR/"
+cp "$BUILD_DIR/.config" "$OUT_DIR/.config"
+echo "$KERNEL_COMMIT $KERNEL_REF" > "$OUT_DIR/kernel-commit"
+build_initramfs
+
+rm -rf "$OUT_DIR/modules"
+if grep -q '^CONFIG_MODULES=y' "$BUILD_DIR/.config"; then
+	kmake modules
+	kmake INSTALL_MOD_PATH="$OUT_DIR/modules" INSTALL_MOD_STRIP=1 modules_install
+fi
+
+echo "built $PROFILE: $OUT_DIR"
@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-2.0
+#
+# Offline check of the trace-bench.sh parsers and trace-diff.sh.
+#
+# Parses the sample serial logs in scripts/testdata/trace/ (console lines in
+# "\r\n" form, a dmesg dump with two initcalls both named "init") and
+# compares the CSV, JSON and diff output with the expected files there.
+# Needs no kernel build, QEMU or network.
+#
+# Usage: scripts/check-trace-parse.sh
+
+set -euo pipefail
+. "$(dirname "$0")/pi-env.sh"
+
+data=$TOPDIR/scripts/testdata/trace
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+for run in a b; do
+	PROFILE=trace TRACE_LOG=$data/boot-$run.log \
+		"$TOPDIR/scripts/trace-bench.sh" "$tmp/$run" >/dev/null
+done
+THRESHOLD=100 "$TOPDIR/scripts/trace-diff.sh" "$tmp/a" "$tmp/b" > "$tmp/diff.txt"
+
+fail=0
+for f in initcalls.csv syscalls.csv summary.json; do
+	diff -u "$data/expected/$f" "$tmp/a/$f" || fail=1
+done
+diff -u "$data/expected/diff.txt" "$tmp/diff.txt" || fail=1
+if grep -l $'\r' "$tmp"/a/*.csv "$tmp"/a/summary.json "$tmp/diff.txt"; then
+	echo "carriage return in output" >&2
+	fail=1
+fi
+
+[ "$fail" = 0 ] || die "trace parser output differs from scripts/testdata/trace/expected"
+echo "trace parsers: ok"
@@ -0,0 +1,114 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-2.0
+#
+# Footprint report: compare the appliance profile against the stock defconfig.
+#
+# For each profile prints the Image and Image.gz size, installed module
+# size, resident kernel memory after boot and boot time under QEMU, with
+# the appliance change relative to stock. Resident memory is physical RAM
+# (from the kernel's "Memory: used/totalK" line) minus MemFree as read by
+# /init, so it covers the kernel image, reserved areas and kernel
+# allocations; the benchmark initramfs adds only a few pages. Boot figures
+# are medians over RUNS boots.
+#
+# A profile is rebuilt first when it has no Image yet, was built from
+# another KERNEL_REF, or one of its config fragments or userspace/init.c is
+# newer than its Image. Otherwise the existing build is measured as is, so
+# the report runs offline. NO_BUILD=1 never builds and only measures.
+#
+# Usage: RUNS=5 [NO_BUILD=1] scripts/footprint-report.sh
+
+set -euo pipefail
+. "$(dirname "$0")/pi-env.sh"
+
+RUNS=${RUNS:-5}
+BASE=stock
+NEW=appliance
+
+need "$QEMU" awk sort du
+
+# profile_fragments <profile>: config fragments build.sh needs for it.
+profile_fragments() {
+	[ "$1" = "$BASE" ] || echo "$TOPDIR/configs/$1.config"
+}
+
+# needs_build <profile>: true if out/<profile> is missing or stale.
+needs_build() {
+	local out=$TOPDIR/out/$1 f
+
+	[ -f "$out/Image" ] && [ -f "$out/kernel-commit" ] || return 0
+	[ "$(cut -d' ' -f2 "$out/kernel-commit")" = "$KERNEL_REF" ] || return 0
+	for f in "$TOPDIR/configs/qemu.config" $(profile_fragments "$1") \
+		 "$TOPDIR/userspace/init.c"; do
+		[ "$f" -nt "$out/Image" ] && return 0
+	done
+	return 1
+}
+
+# measure <profile>: print "<image> <image_gz> <modules> <resident> <init> <userspace>"
+# with sizes in KiB and times in seconds.
+measure() {
+	local profile=$1 PROFILE=$1 OUT_DIR=$TOPDIR/out/$1 log i mods=0
+
+	if [ -n "${NO_BUILD:-}" ]; then
+		check_artefacts
+		[ -f "$OUT_DIR/Image.gz" ] ||
+			die "$OUT_DIR/Image.gz missing, run PROFILE=$PROFILE scripts/build.sh first"
+	elif needs_build "$profile"; then
+		# shellcheck disable=SC2046
+		PROFILE=$profile OUT_DIR=$OUT_DIR BUILD_DIR=$TOPDIR/build/$profile \
+			"$TOPDIR/scripts/build.sh" $(profile_fragments "$profile") >&2
+	fi
+	[ -d "$OUT_DIR/modules" ] && mods=$(du -sk "$OUT_DIR/modules" | cut -f1)
+
+	mkdir -p "$OUT_DIR/logs"
+	# Not local: the EXIT trap of this $(...) subshell runs after return.
+	results=$(mktemp)
+	trap 'rm -f "$results"' EXIT
+	for i in $(seq 1 "$RUNS"); do
+		log=$OUT_DIR/logs/footprint-$i.log
+		qemu_boot "$log" >&2 ||
+			die "$profile run $i: no boot within ${BOOT_TIMEOUT}s, see $log"
+		{
+			boot_times "$log" | tr -d '\n'
+			awk '
+			{ sub(/\r$/, "") }
+			/Memory: [0-9]+K\/[0-9]+K available/ {
+				if (match($0, /\/[0-9]+K/))
+					phys = substr($0, RSTART + 1, RLENGTH - 2)
+			}
+			/^PI-BENCH meminfo/ { total = $3; free = $4 }
+			END { printf " %d\n", (phys ? phys : total) - free }
+			' "$log"
+		} >> "$results"
+	done
+
+	printf '%d %d %d %s %s %s\n' \
+		$(( ($(stat -c %s "$OUT_DIR/Image") + 1023) / 1024 )) \
+		$(( ($(stat -c %s "$OUT_DIR/Image.gz") + 1023) / 1024 )) \
+		"$mods" \
+		"$(awk '{ print $4 }' "$results" | median)" \
+		"$(awk '{ print $1 }' "$results" | median)" \
+		"$(awk '{ print $2 }' "$results" | median)"
+}
+
+base=$(measure "$BASE")
+new=$(measure "$NEW")
+
+echo
+printf '%-22s %12s %12s %10s\n' metric "$BASE" "$NEW" change
+awk -v base="$base" -v new="$new" '
+function row(label, unit, fmt, a, b) {
+	printf "%-22s %10" fmt " %s %10" fmt " %s %9s\n", label, a, unit, b, unit,
+		(a > 0 ? sprintf("%+.1f%%", (b - a) * 100 / a) : "-")
+}
+BEGIN {
+	split(base, x, " ")
+	split(new, y, " ")
+	row("Image", "K", "d", x[1], y[1])
+	row("Image.gz", "K", "d", x[2], y[2])
+	row("modules", "K", "d", x[3], y[3])
+	row("resident kernel mem", "K", "d", x[4], y[4])
+	row("time to init", "s", ".3f", x[5], y[5])
+	row("time to userspace", "s", ".3f", x[6], y[6])
+}'
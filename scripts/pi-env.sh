@@ -0,0 +1,111 @@
+# SPDX-License-Identifier: GPL-2.0
+#
+# Common settings shared by the pi-linux helper scripts. Sourced, not run.
+#
+# Every value can be overridden from the environment, e.g.
+#   KERNEL_REF=stable_20240529 CROSS_COMPILE=aarch64-none-linux-gnu- scripts/build.sh
+
+TOPDIR=$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)
+
+# Kernel source. The tree is not vendored into this repository; build.sh
+# checks it out at KERNEL_REF on every run so every build starts from the
+# same code. KERNEL_REF must be a commit SHA or a release tag, never a
+# branch: a branch moves and baselines taken on it stop being comparable.
+KERNEL_URL=${KERNEL_URL:-https://github.com/raspberrypi/linux.git}
+KERNEL_REF=${KERNEL_REF:-stable_20240529}
+KERNEL_SRC=${KERNEL_SRC:-$TOPDIR/linux}
+
+ARCH=arm64
+CROSS_COMPILE=${CROSS_COMPILE:-aarch64-linux-gnu-}
+JOBS=${JOBS:-$(nproc)}
+
+DEFCONFIG=${DEFCONFIG:-bcmrpi3_defconfig}
+DTB_NAME=bcm2710-rpi-3-b.dtb
+
+# Per-profile build and artefact directories.
+PROFILE=${PROFILE:-stock}
+BUILD_DIR=${BUILD_DIR:-$TOPDIR/build/$PROFILE}
+OUT_DIR=${OUT_DIR:-$TOPDIR/out/$PROFILE}
+
+QEMU=${QEMU:-qemu-system-aarch64}
+QEMU_MACHINE=raspi3b
+QEMU_MEM=1G
+BOOT_TIMEOUT=${BOOT_TIMEOUT:-120}
+
+export ARCH CROSS_COMPILE
+
+die() {
+	echo "${0##*/}: $*" >&2
+	exit 1
+}
+
+need() {
+	local tool
+	for tool in "$@"; do
+		command -v "$tool" >/dev/null 2>&1 || die "missing tool: $tool"
+	done
+}
+
+kmake() {
+	make -C "$KERNEL_SRC" O="$BUILD_DIR" -j"$JOBS" "$@"
+}
+
+# check_artefacts: make sure scripts/build.sh has produced a bootable set.
+check_artefacts() {
+	local f
+
+	for f in Image "$DTB_NAME" initramfs.cpio.gz; do
+		[ -f "$OUT_DIR/$f" ] ||
+			die "$OUT_DIR/$f missing, run PROFILE=$PROFILE scripts/build.sh first"
+	done
+}
+
+# qemu_boot <log> [cmdline...]: boot $OUT_DIR once with the serial console
+# captured in <log>, stop QEMU once /init reports done. Fails on timeout.
+qemu_boot() {
+	local log=$1 deadline=$((SECONDS + BOOT_TIMEOUT)) pid start end
+
+	: > "$log"
+	start=$(date +%s.%N)
+	"$QEMU" -M "$QEMU_MACHINE" -m "$QEMU_MEM" \
+		-kernel "$OUT_DIR/Image" \
+		-dtb "$OUT_DIR/$DTB_NAME" \
+		-initrd "$OUT_DIR/initramfs.cpio.gz" \
+		-append "console=ttyAMA0,115200 rdinit=/init printk.time=1 ${*:2}" \
+		-display none -monitor none -serial "file:$log" -no-reboot &
+	pid=$!
+
+	while ! grep -q '^PI-BENCH done' "$log" 2>/dev/null; do
+		if ! kill -0 "$pid" 2>/dev/null || [ "$SECONDS" -ge "$deadline" ]; then
+			kill "$pid" 2>/dev/null || true
+			wait "$pid" 2>/dev/null || true
+			return 1
+		fi
+		sleep 0.05
+	done
+	end=$(date +%s.%N)
+	kill "$pid" 2>/dev/null || true
+	wait "$pid" 2>/dev/null || true
+
+	awk -v s="$start" -v e="$end" 'BEGIN { printf "PI-BENCH wall %.3f\n", e - s }' >> "$log"
+}
+
+# boot_times <log>: print "<init> <userspace> <wall>" seconds for one boot.
+boot_times() {
+	awk '
+	{ sub(/\r$/, "") }
+	/Run \/init as init process/ {
+		if (match($0, /\[ *[0-9]+\.[0-9]+\]/))
+			init = substr($0, RSTART + 1, RLENGTH - 2) + 0
+	}
+	/^PI-BENCH userspace/ { user = $3 }
+	/^PI-BENCH wall/      { wall = $3 }
+	END { printf "%.3f %.3f %.3f\n", init, user, wall }
+	' "$1"
+}
+
+# median: median of the numbers on stdin, one per line.
+median() {
+	sort -n | awk '{ v[NR] = $1 }
+		END { print (NR % 2) ? v[(NR + 1) / 2] : (v[NR / 2] + v[NR / 2 + 1]) / 2 }'
+}
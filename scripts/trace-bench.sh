@@ -0,0 +1,97 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-2.0
+#
+# Boot and hot-path tracing harness under qemu-system-aarch64 -M raspi3b.
+#
+# Boots a kernel built with configs/trace.config using initcall_debug and
+# pi_bench=trace, then writes to $RESULTS_DIR:
+#   initcalls.csv  initcall,usecs,ret         one row per initcall, in boot order
+#   syscalls.csv   syscall,iters,user_ns,kernel_ns
+#                  user_ns: round trip from /init; kernel_ns: function_graph
+#                  duration of the syscall entry point (-1 if not traced)
+#   summary.json   boot times, initcall totals and the syscall table
+#   boot.log       raw serial console
+#
+# Usage:
+#   PROFILE=trace scripts/build.sh configs/trace.config
+#   PROFILE=trace scripts/trace-bench.sh [results-dir]
+# With TRACE_LOG=<boot.log> an earlier boot is parsed again instead of
+# booting QEMU; scripts/check-trace-parse.sh uses this on a sample log.
+# Compare two result directories with scripts/trace-diff.sh.
+
+set -euo pipefail
+PROFILE=${PROFILE:-trace}
+. "$(dirname "$0")/pi-env.sh"
+
+RESULTS_DIR=${1:-$OUT_DIR/results}
+
+need awk sort
+mkdir -p "$RESULTS_DIR"
+log=$RESULTS_DIR/boot.log
+
+if [ -n "${TRACE_LOG:-}" ]; then
+	[ -f "$TRACE_LOG" ] || die "$TRACE_LOG: no such boot log"
+	[ "$TRACE_LOG" -ef "$log" ] || cp "$TRACE_LOG" "$log"
+else
+	need "$QEMU"
+	check_artefacts
+	grep -q '^CONFIG_FUNCTION_GRAPH_TRACER=y' "$OUT_DIR/.config" ||
+		echo "${0##*/}: warning: $PROFILE lacks configs/trace.config, kernel_ns will be -1" >&2
+	qemu_boot "$log" initcall_debug pi_bench=trace ${BOOT_ARGS:-} ||
+		die "no boot within ${BOOT_TIMEOUT}s, see $log"
+fi
+
+# Everything /init prints went through the serial console, which ends each
+# line with "\r\n"; every awk below drops the "\r" before parsing.
+#
+# "initcall foo+0x0/0x40 returned 0 after 12 usecs", taken only from the
+# dmesg dump: it holds every initcall exactly once, whatever the console
+# loglevel. Static initcalls may share a name, so rows are not merged.
+{
+	echo "initcall,usecs,ret"
+	awk '
+	{ sub(/\r$/, "") }
+	/^PI-BENCH dmesg-begin/ { in_dmesg = 1; next }
+	/^PI-BENCH dmesg-end/   { in_dmesg = 0; next }
+	in_dmesg && /initcall .* returned .* after [0-9]+ usecs/ {
+		for (i = 1; i < NF; i++)
+			if ($i == "initcall")
+				break
+		name = $(i + 1)
+		sub(/\+0x.*/, "", name)
+		printf "%s,%s,%s\n", name, $(i + 5), $(i + 3)
+	}' "$log"
+} > "$RESULTS_DIR/initcalls.csv"
+
+# slowest_initcalls: initcalls.csv with its rows sorted slowest first.
+slowest_initcalls() {
+	head -n 1 "$RESULTS_DIR/initcalls.csv"
+	tail -n +2 "$RESULTS_DIR/initcalls.csv" | sort -t, -k2,2nr
+}
+
+{
+	echo "syscall,iters,user_ns,kernel_ns"
+	awk '{ sub(/\r$/, "") }
+	/^PI-BENCH syscall / { printf "%s,%s,%s,%s\n", $3, $4, $5, $6 }' "$log"
+} > "$RESULTS_DIR/syscalls.csv"
+
+read -r init user wall < <(boot_times "$log")
+awk -F, -v profile="$PROFILE" -v init="$init" -v user="$user" -v wall="$wall" '
+FNR == 1 { file++; next }
+file == 1 { n_init++; total += $2; if (n_init <= 10) top[n_init] = sprintf("{\"initcall\": \"%s\", \"usecs\": %d}", $1, $2) }
+file == 2 { sc[++n_sc] = sprintf("{\"syscall\": \"%s\", \"iters\": %d, \"user_ns\": %s, \"kernel_ns\": %s}", $1, $2, $3, $4) }
+END {
+	printf "{\n  \"profile\": \"%s\",\n", profile
+	printf "  \"boot\": {\"init_s\": %.3f, \"userspace_s\": %.3f, \"wall_s\": %.3f},\n", init, user, wall
+	printf "  \"initcalls\": {\"count\": %d, \"total_usecs\": %d, \"slowest\": [", n_init, total
+	for (i = 1; i <= n_init && i <= 10; i++)
+		printf "%s\n    %s", (i > 1 ? "," : ""), top[i]
+	printf "\n  ]},\n  \"syscalls\": ["
+	for (i = 1; i <= n_sc; i++)
+		printf "%s\n    %s", (i > 1 ? "," : ""), sc[i]
+	printf "\n  ]\n}\n"
+}' <(slowest_initcalls) "$RESULTS_DIR/syscalls.csv" > "$RESULTS_DIR/summary.json"
+
+echo "results: $RESULTS_DIR"
+slowest_initcalls | head -n 11 | { column -t -s, 2>/dev/null || cat; }
+column -t -s, "$RESULTS_DIR/syscalls.csv" 2>/dev/null || cat "$RESULTS_DIR/syscalls.csv"
@@ -0,0 +1,52 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: GPL-2.0
+#
+# Compare two scripts/trace-bench.sh result directories.
+#
+# Prints initcalls whose duration changed by at least THRESHOLD usecs
+# (default 100), largest change first, then the syscall latencies side by
+# side. Initcalls present in only one build are shown with the other side 0;
+# repeated initcall names are numbered foo, foo#2, ... in file order.
+#
+# Usage: scripts/trace-diff.sh <base-results> <new-results>
+
+set -euo pipefail
+. "$(dirname "$0")/pi-env.sh"
+
+[ $# -eq 2 ] || die "usage: ${0##*/} <base-results> <new-results>"
+base=$1
+new=$2
+THRESHOLD=${THRESHOLD:-100}
+
+for d in "$base" "$new"; do
+	[ -f "$d/initcalls.csv" ] && [ -f "$d/syscalls.csv" ] ||
+		die "$d: not a trace-bench result directory"
+done
+
+echo "initcall,base_usecs,new_usecs,delta_usecs"
+awk -F, -v t="$THRESHOLD" '
+FNR == 1 { file++; delete seen; next }
+# Static initcalls can share a name: the nth "foo" matches the nth "foo".
+{ key = $1; if (seen[$1]++) key = $1 "#" seen[$1]; names[key] = 1 }
+file == 1 { a[key] = $2 }
+file == 2 { b[key] = $2 }
+END {
+	for (n in names) {
+		d = b[n] - a[n]
+		if (d >= t || -d >= t)
+			printf "%s,%d,%d,%+d\n", n, a[n], b[n], d
+	}
+}' "$base/initcalls.csv" "$new/initcalls.csv" |
+	awk -F, '{ print ($4 < 0 ? -$4 : $4) "\t" $0 }' |
+	sort -k1,1nr | cut -f2-
+
+echo
+echo "syscall,base_user_ns,new_user_ns,base_kernel_ns,new_kernel_ns"
+awk -F, '
+FNR == 1 { file++; next }
+file == 1 { u[$1] = $3; k[$1] = $4; order[++n] = $1 }
+file == 2 { nu[$1] = $3; nk[$1] = $4 }
+END {
+	for (i = 1; i <= n; i++)
+		printf "%s,%s,%s,%s,%s\n", order[i], u[order[i]], nu[order[i]], k[order[i]], nk[order[i]]
+}' "$base/syscalls.csv" "$new/syscalls.csv"
@@ -0,0 +1,279 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Minimal /init for the QEMU benchmark initramfs.
+ *
+ * It reports how long the kernel took to reach userspace and how much
+ * memory the kernel holds once booted, then shuts the machine down, so a
+ * boot can be timed without a real root filesystem.
+ * Built statically; it must not depend on anything inside the initramfs.
+ *
+ * Booting with pi_bench=trace (the kernel hands unknown parameters to init
+ * as environment) also runs a syscall latency microbenchmark, times the
+ * same syscalls in the kernel with the function_graph tracer, and dumps
+ * the kernel log so initcall_debug output can be collected.
+ */
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/klog.h>
+#include <sys/mount.h>
+#include <sys/reboot.h>
+#include <sys/syscall.h>
+
+#define TRACEFS		"/sys/kernel/tracing"
+#define ITERS		20000
+#define TRACE_ITERS	200
+
+struct bench {
+	const char *name;	/* syscall name in the output */
+	const char *func;	/* kernel entry point traced by ftrace */
+	void (*run)(void);
+	double user_ns;
+	double kernel_ns;
+	long kernel_hits;
+};
+
+static int null_fd = -1, zero_fd = -1;
+
+static void run_getppid(void)
+{
+	syscall(SYS_getppid);
+}
+
+static void run_read(void)
+{
+	char c;
+
+	if (read(zero_fd, &c, 1) < 0)
+		perror("read");
+}
+
+static void run_write(void)
+{
+	if (write(null_fd, "", 1) < 0)
+		perror("write");
+}
+
+static void run_openat(void)
+{
+	int fd = open("/dev/null", O_RDONLY);
+
+	if (fd >= 0)
+		close(fd);
+}
+
+static struct bench benches[] = {
+	{ "getppid", "__arm64_sys_getppid", run_getppid },
+	{ "read",    "__arm64_sys_read",    run_read },
+	{ "write",   "__arm64_sys_write",   run_write },
+	{ "openat",  "__arm64_sys_openat",  run_openat },
+};
+
+#define NR_BENCHES (sizeof(benches) / sizeof(benches[0]))
+
+static double read_uptime(void)
+{
+	double up = -1.0;
+	FILE *f = fopen("/proc/uptime", "r");
+
+	if (!f)
+		return up;
+	if (fscanf(f, "%lf", &up) != 1)
+		up = -1.0;
+	fclose(f);
+	return up;
+}
+
+/* PI-BENCH meminfo <MemTotal> <MemFree> <MemAvailable>, all in kB. */
+static void print_meminfo(void)
+{
+	long total = -1, free_kb = -1, avail = -1;
+	char line[128];
+	FILE *f = fopen("/proc/meminfo", "r");
+
+	if (!f)
+		return;
+	while (fgets(line, sizeof(line), f)) {
+		sscanf(line, "MemTotal: %ld kB", &total);
+		sscanf(line, "MemFree: %ld kB", &free_kb);
+		sscanf(line, "MemAvailable: %ld kB", &avail);
+	}
+	fclose(f);
+	printf("PI-BENCH meminfo %ld %ld %ld\n", total, free_kb, avail);
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int write_file(const char *path, const char *val)
+{
+	int fd = open(path, O_WRONLY | O_TRUNC);
+	ssize_t n;
+
+	if (fd < 0)
+		return -1;
+	n = write(fd, val, strlen(val));
+	close(fd);
+	return n < 0 ? -1 : 0;
+}
+
+/* Userspace round trip: mean over ITERS calls after a short warm-up. */
+static void bench_user(struct bench *b)
+{
+	double t0;
+	int i;
+
+	for (i = 0; i < ITERS / 10; i++)
+		b->run();
+	t0 = now_ns();
+	for (i = 0; i < ITERS; i++)
+		b->run();
+	b->user_ns = (now_ns() - t0) / ITERS;
+}
+
+/*
+ * Parse one function_graph line, e.g.
+ *   " 0)   0.875 us    |  __arm64_sys_getppid();"
+ * Duration markers ('+', '!', '#', ...) may precede the number.
+ */
+static void account_trace_line(const char *line)
+{
+	const char *bar = strchr(line, '|');
+	const char *p = strchr(line, ')');
+	double us;
+	size_t i;
+
+	if (!bar || !p || p > bar)
+		return;
+	for (p++; p < bar && !(*p >= '0' && *p <= '9'); p++)
+		;
+	if (p == bar || sscanf(p, "%lf us", &us) != 1)
+		return;
+	for (i = 0; i < NR_BENCHES; i++) {
+		size_t len = strlen(benches[i].func);
+		const char *f = strstr(bar, benches[i].func);
+
+		if (f && f[len] == '(') {
+			benches[i].kernel_ns += us * 1000.0;
+			benches[i].kernel_hits++;
+			return;
+		}
+	}
+}
+
+/* In-kernel time of each syscall, measured with function_graph at depth 1. */
+static void bench_kernel(void)
+{
+	char filter[256] = "", line[512];
+	FILE *trace;
+	size_t i;
+	int n;
+
+	if (mount("tracefs", TRACEFS, "tracefs", 0, NULL) &&
+	    access(TRACEFS "/tracing_on", F_OK)) {
+		perror("mount tracefs");
+		return;
+	}
+	for (i = 0; i < NR_BENCHES; i++) {
+		strcat(filter, benches[i].func);
+		strcat(filter, " ");
+	}
+	if (write_file(TRACEFS "/tracing_on", "0") ||
+	    write_file(TRACEFS "/set_graph_function", filter) ||
+	    write_file(TRACEFS "/max_graph_depth", "1") ||
+	    write_file(TRACEFS "/current_tracer", "function_graph")) {
+		fprintf(stderr, "function_graph tracer unavailable\n");
+		return;
+	}
+	write_file(TRACEFS "/trace", "");
+
+	write_file(TRACEFS "/tracing_on", "1");
+	for (i = 0; i < NR_BENCHES; i++)
+		for (n = 0; n < TRACE_ITERS; n++)
+			benches[i].run();
+	write_file(TRACEFS "/tracing_on", "0");
+
+	trace = fopen(TRACEFS "/trace", "r");
+	if (!trace)
+		return;
+	while (fgets(line, sizeof(line), trace))
+		account_trace_line(line);
+	fclose(trace);
+	write_file(TRACEFS "/current_tracer", "nop");
+}
+
+static void bench_syscalls(void)
+{
+	size_t i;
+
+	mount("devtmpfs", "/dev", "devtmpfs", 0, NULL);
+	mount("sysfs", "/sys", "sysfs", 0, NULL);
+	null_fd = open("/dev/null", O_WRONLY);
+	zero_fd = open("/dev/zero", O_RDONLY);
+	if (null_fd < 0 || zero_fd < 0) {
+		perror("open /dev");
+		return;
+	}
+
+	for (i = 0; i < NR_BENCHES; i++)
+		bench_user(&benches[i]);
+	bench_kernel();
+
+	/* PI-BENCH syscall <name> <iters> <user ns/op> <kernel ns/op> */
+	for (i = 0; i < NR_BENCHES; i++) {
+		struct bench *b = &benches[i];
+
+		printf("PI-BENCH syscall %s %d %.1f %.1f\n", b->name, ITERS,
+		       b->user_ns,
+		       b->kernel_hits ? b->kernel_ns / b->kernel_hits : -1.0);
+	}
+}
+
+static void dump_kernel_log(void)
+{
+	int len = klogctl(10 /* SYSLOG_ACTION_SIZE_BUFFER */, NULL, 0);
+	char *buf;
+
+	if (len <= 0)
+		return;
+	buf = malloc(len);
+	if (!buf)
+		return;
+	len = klogctl(3 /* SYSLOG_ACTION_READ_ALL */, buf, len);
+	if (len > 0) {
+		printf("PI-BENCH dmesg-begin\n");
+		fwrite(buf, 1, len, stdout);
+		printf("PI-BENCH dmesg-end\n");
+	}
+	free(buf);
+}
+
+int main(void)
+{
+	const char *mode = getenv("pi_bench");
+
+	mount("proc", "/proc", "proc", 0, NULL);
+
+	printf("PI-BENCH userspace %.3f\n", read_uptime());
+	print_meminfo();
+	if (mode && !strcmp(mode, "trace")) {
+		bench_syscalls();
+		dump_kernel_log();
+	}
+	printf("PI-BENCH done\n");
+	fflush(stdout);
+
+	sync();
+	reboot(RB_POWER_OFF);
+	/* raspi3b has no power-off; the host kills QEMU on "done". */
+	for (;;)
+		pause();
+}